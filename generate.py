@@ -20,6 +20,41 @@ cmdversions = {
 	"vkCmdSetDispatchParametersARM": 2,
 }
 
+# commands included in VolkCustomDeviceTable unless a different list is specified via --custom-device-table
+custom_device_commands = [
+	"vkCmdBeginRendering",
+	"vkCmdBindDescriptorSets",
+	"vkCmdBindIndexBuffer",
+	"vkCmdBindPipeline",
+	"vkCmdBindVertexBuffers",
+	"vkCmdCopyBuffer",
+	"vkCmdDispatch",
+	"vkCmdDraw",
+	"vkCmdDrawIndexed",
+	"vkCmdDrawIndexedIndirect",
+	"vkCmdDrawIndirect",
+	"vkCmdEndRendering",
+	"vkCmdPipelineBarrier",
+	"vkCmdPipelineBarrier2",
+	"vkCmdPushConstants",
+	"vkCmdSetScissor",
+	"vkCmdSetViewport",
+]
+
+# commands placed at the start of VolkDeviceTable with --hot-device-table; these are commonly called for every draw or dispatch
+hot_device_commands = [
+	r'vkCmdDraw\w*',
+	r'vkCmdDispatch\w*',
+	r'vkCmdBind\w*',
+	r'vkCmdPushConstants\w*',
+	r'vkCmdPushDescriptorSet\w*',
+	r'vkCmdPipelineBarrier\w*',
+	r'vkCmdSetViewport',
+	r'vkCmdSetScissor',
+	r'vkCmdBeginRendering\w*',
+	r'vkCmdEndRendering\w*',
+]
+
 def parse_xml(path):
 	file = urllib.request.urlopen(path) if path.startswith("http") else open(path, 'r')
 	with file:
@@ -62,21 +97,310 @@ def is_descendant_type(types, name, base):
 		return False
 	return any([is_descendant_type(types, parent, base) for parent in parents.split(',')])
 
+def parse_requirements(key, features):
+	tokens = re.findall(r'defined\(\w+\)|\w+ >= \d+|&&|\|\||\(|\)', key)
+	assert(''.join(tokens).replace(' ', '') == key.replace(' ', ''))
+	code = []
+	pos = 0
+
+	# recursive descent over the preprocessor expression; the result is in postfix form
+	def expr():
+		nonlocal pos
+		term()
+		while pos < len(tokens) and tokens[pos] == '||':
+			pos += 1
+			term()
+			code.append('VOLK_REQUIRE_OR')
+
+	def term():
+		nonlocal pos
+		factor()
+		while pos < len(tokens) and tokens[pos] == '&&':
+			pos += 1
+			factor()
+			code.append('VOLK_REQUIRE_AND')
+
+	def factor():
+		nonlocal pos
+		token = tokens[pos]
+		pos += 1
+		if token == '(':
+			expr()
+			assert(tokens[pos] == ')')
+			pos += 1
+		elif token.startswith('defined('):
+			code.append(features.index(token[8:-1]))
+		else: # extension spec version check is resolved at compile time
+			code.append('VOLK_REQUIRE_TRUE')
+
+	expr()
+	assert(pos == len(tokens))
+
+	# volkGenLoadDeviceTableEx evaluates the expression using a fixed size stack
+	depth = 0
+	for c in code:
+		depth += -1 if c in ('VOLK_REQUIRE_AND', 'VOLK_REQUIRE_OR') else 1
+		assert(depth <= 16)
+
+	return code
+
+def parse_command_list(path):
+	with open(path, 'r') as file:
+		lines = [line.split('#')[0].strip() for line in file.readlines()]
+		return [line for line in lines if line]
+
+def parse_profile(path):
+	profile = {}
+	with open(path, 'r') as file:
+		for line in file.readlines():
+			fields = line.split('#')[0].split()
+			if fields:
+				profile[fields[0]] = profile.get(fields[0], 0) + int(fields[1])
+	return profile
+
 def defined(key):
 	return 'defined(' + key + ')'
 
 def cdepends(key):
 	return re.sub(r'[a-zA-Z0-9_]+', lambda m: defined(m.group(0)), key).replace(',', ' || ').replace('+', ' && ')
 
+# scalar types from vk_platform.h; they are captured by value
+scalar_types = ['char', 'float', 'double', 'int', 'int8_t', 'int16_t', 'int32_t', 'int64_t', 'uint8_t', 'uint16_t', 'uint32_t', 'uint64_t', 'size_t']
+
+def declaration(elem):
+	# text of a <param> or <member> declaration before and after the name, e.g. 'const VkFoo* ' and '[4]'; comments are ignored
+	parts = ([elem.text or ''], [])
+	current = 0
+	for child in elem:
+		if child.tag == 'name':
+			current = 1
+		elif child.tag != 'comment':
+			parts[current].append(child.text or '')
+		parts[current].append(child.tail or '')
+	return (''.join(parts[0]), ''.join(parts[1]))
+
+def api_filter(elems):
+	return [elem for elem in elems if elem.get('api') is None or 'vulkan' in elem.get('api').split(',')]
+
+def parse_params(spec, type_groups, commands, cmdnames):
+	types = {}
+	aliases = {}
+
+	for type in api_filter(spec.findall('types/type')):
+		name = type.get('name') or type.findtext('name')
+		if type.get('alias'):
+			aliases[name] = type.get('alias')
+		elif name:
+			types[name] = type
+
+	def resolve(name):
+		while name in aliases:
+			name = aliases[name]
+		return name
+
+	plain = {}
+
+	# structures and unions that only contain values are captured as a single value
+	def is_plain(name):
+		if name not in plain:
+			plain[name] = False
+			result = True
+			for member in api_filter(types[name].findall('member')):
+				(before, after) = declaration(member)
+				if '*' in before or after.strip().startswith(':') or member.findtext('name') == 'sType' or classify(resolve(member.findtext('type'))) != 'VALUE':
+					result = False
+			plain[name] = result
+		return plain[name]
+
+	def classify(name):
+		if name in scalar_types:
+			return 'VALUE'
+		type = types.get(name)
+		if type is None:
+			return None
+		category = type.get('category')
+		text = ''.join(type.itertext())
+		if category == 'handle':
+			return 'HANDLE'
+		if category in ('enum', 'bitmask') or (category == 'basetype' and '*' not in text and 'struct' not in text):
+			return 'VALUE'
+		if category == 'funcpointer':
+			return 'ZERO'
+		if category in ('struct', 'union') and is_plain(name):
+			return 'VALUE'
+		if category == 'struct':
+			return 'STRUCT'
+		return None
+
+	# element count of an array: a constant, a preceding parameter or member, a member of the structure that a preceding parameter points to, or an altlen expression
+	def parse_length(field, expr, preceding):
+		if expr.isdigit():
+			field['length'] = ('const', expr)
+			return True
+		member = re.fullmatch(r'(\w+)->(\w+)', expr)
+		if member and member.group(1) in preceding:
+			(index, elem) = preceding[member.group(1)]
+			target = types.get(resolve(elem.findtext('type')))
+			names = [m.findtext('name') for m in api_filter(target.findall('member'))] if target is not None and target.get('category') == 'struct' else []
+			if member.group(2) not in names:
+				return False
+			field['length'] = ('field', index)
+			field['member'] = (resolve(elem.findtext('type')), names.index(member.group(2)))
+			return True
+		scaled = re.fullmatch(r'\(?(\w+)(?: \+ (\d+))?\)? / (\d+)', expr)
+		if scaled and scaled.group(1) in preceding:
+			divisor = int(scaled.group(3))
+			if divisor & (divisor - 1) or int(scaled.group(2) or 0) > 255:
+				return False
+			field['length'] = ('field', preceding[scaled.group(1)][0])
+			field['shift'] = divisor.bit_length() - 1
+			field['round'] = int(scaled.group(2) or 0)
+			return True
+		if expr in preceding:
+			field['length'] = ('field', preceding[expr][0])
+			return True
+		return False
+
+	# describes how a parameter or member is serialized; returns None for declarations that can't be serialized
+	def describe(elem, owner, preceding):
+		type = resolve(elem.findtext('type'))
+		name = elem.findtext('name')
+		(before, after) = declaration(elem)
+		depth = before.count('*')
+		dims = re.findall(r'\[(\w+)\]', after)
+		length = elem.get('altlen') if (elem.get('len') or '').startswith('latexmath') else elem.get('len')
+		lengths = length.split(',') if length and depth else []
+		field = {'name': name, 'type': type, 'kind': None, 'flags': [], 'size': '0', 'shift': 0, 'round': 0, 'struct': None, 'length': None, 'member': None}
+
+		if after.strip().startswith(':'):
+			return None
+		if owner and name == 'pNext' and type == 'void' and depth == 1:
+			field['kind'] = 'NEXT'
+			return field
+		# allocation callbacks, user data and function pointers are replayed as NULL
+		if type == 'VkAllocationCallbacks' or (type == 'void' and depth == 1 and name == 'pUserData') or classify(type) == 'ZERO':
+			field['kind'] = 'ZERO'
+			return field
+
+		if type == 'char' and lengths and lengths[-1] == 'null-terminated' and depth == len(lengths):
+			field['kind'] = 'STRING'
+			field['size'] = 'sizeof(char*)'
+			depth -= 1
+			lengths = lengths[:-1]
+		elif type == 'void' and depth == 2 and not lengths:
+			field['kind'] = 'VALUE'
+			field['size'] = 'sizeof(void*)'
+			depth -= 1
+		elif type == 'void' and depth == 1 and len(lengths) == 1:
+			field['kind'] = 'VALUE'
+			field['size'] = '1'
+		else:
+			field['kind'] = classify(type)
+			field['size'] = 'sizeof(' + type + ')'
+			field['struct'] = type if field['kind'] == 'STRUCT' else None
+			if field['kind'] is None:
+				return None
+
+		if depth > 1 or len(lengths) > 1:
+			return None
+		elif depth == 1:
+			field['flags'].append('VOLK_PARAM_POINTER')
+			if lengths and not parse_length(field, lengths[0], preceding):
+				return None
+			if not lengths:
+				field['length'] = ('const', '1')
+			# handles that are written by commands are mapped to the handles created during replay
+			if not owner and field['kind'] == 'HANDLE' and not before.strip().startswith('const'):
+				field['flags'].append('VOLK_PARAM_OUTPUT')
+		elif dims and not owner:
+			field['flags'].append('VOLK_PARAM_POINTER')
+			field['length'] = ('const', ' * '.join(dims))
+		elif dims and field['kind'] == 'VALUE':
+			field['size'] += ' * ' + ' * '.join(dims)
+		elif dims:
+			field['length'] = ('const', ' * '.join(dims))
+
+		if field['kind'] == 'HANDLE' and type == 'VkDevice':
+			field['flags'].append('VOLK_PARAM_DEVICE')
+
+		return field
+
+	def describe_all(elems, owner):
+		fields = []
+		preceding = {}
+		for elem in elems:
+			field = describe(elem, owner, preceding)
+			if field is None:
+				return None
+			preceding[field['name']] = (len(fields), elem)
+			fields.append(field)
+		return fields
+
+	structs = OrderedDict()
+
+	for (name, type) in types.items():
+		if type.get('category') != 'struct' or is_plain(name) or name not in type_groups:
+			continue
+		fields = describe_all(api_filter(type.findall('member')), name)
+		stype = [field for field in fields or [] if field['name'] == 'sType']
+		stype = type.find('member[name="sType"]').get('values') if stype else 'VOLK_PARAM_UNTYPED'
+		# structures need at least one serialized field so that the size of an array bounds its element count
+		if fields and stype and ',' not in stype and any([field['kind'] != 'ZERO' for field in fields]):
+			structs[name] = {'fields': fields, 'sType': stype, 'group': ' || '.join(sorted(type_groups[name]))}
+
+	# structures that contain structures that can't be serialized can't be serialized either
+	changed = True
+	while changed:
+		changed = False
+		for name in list(structs.keys()):
+			if any([field['struct'] and field['struct'] not in structs for field in structs[name]['fields']]):
+				del structs[name]
+				changed = True
+
+	params = {}
+
+	for name in cmdnames:
+		fields = describe_all(api_filter(commands[name].findall('param')), None)
+		# the device that captured commands are replayed on belongs to the caller, so it is never destroyed during replay
+		if name == 'vkDestroyDevice' or fields is None or len(fields) > 32 or any([field['struct'] and field['struct'] not in structs for field in fields]):
+			continue
+		# the last handle passed to vkDestroy* and vkFree* commands is no longer valid after the call
+		handles = [field for field in fields if field['kind'] == 'HANDLE' and 'VOLK_PARAM_OUTPUT' not in field['flags'] and 'VOLK_PARAM_DEVICE' not in field['flags']]
+		if re.match(r'vk(Destroy|Free)', name) and handles:
+			handles[-1]['flags'].append('VOLK_PARAM_DESTROY')
+		params[name] = fields
+
+	return (structs, params)
+
 if __name__ == "__main__":
 	specpath = "https://raw.githubusercontent.com/KhronosGroup/Vulkan-Docs/main/xml/vk.xml"
+	args = sys.argv[1:]
+
+	# --custom-device-table <file> replaces the default command list for VolkCustomDeviceTable; the file lists one command per line
+	if '--custom-device-table' in args:
+		i = args.index('--custom-device-table')
+		custom_device_commands = parse_command_list(args[i + 1])
+		del args[i:i + 2]
+
+	# --hot-device-table moves commands matching hot_device_commands to the start of VolkDeviceTable, keeping them in a few cache lines
+	hot_device_table = '--hot-device-table' in args
+	if hot_device_table:
+		args.remove('--hot-device-table')
 
-	if len(sys.argv) > 1:
-		specpath = sys.argv[1]
+	# --profile <file> orders VolkInstanceTable and VolkDeviceTable by call counts written by volkWriteProfile; called commands are placed first, most frequent first
+	profile = None
+	if '--profile' in args:
+		i = args.index('--profile')
+		profile = parse_profile(args[i + 1])
+		del args[i:i + 2]
+
+	if len(args) > 0:
+		specpath = args[0]
 
 	spec = parse_xml(specpath)
 
-	block_keys = ('INSTANCE_TABLE', 'DEVICE_TABLE', 'PROTOTYPES_H', 'PROTOTYPES_H_DEVICE', 'PROTOTYPES_C', 'LOAD_LOADER', 'LOAD_INSTANCE', 'LOAD_INSTANCE_TABLE', 'LOAD_DEVICE', 'LOAD_DEVICE_TABLE')
+	block_keys = ('INSTANCE_TABLE', 'DEVICE_TABLE', 'PROTOTYPES_H', 'PROTOTYPES_H_DEVICE', 'PROTOTYPES_C')
+	load_keys = ('LOADER', 'INSTANCE', 'DEVICE')
 
 	blocks = {}
 
@@ -86,6 +410,7 @@ if __name__ == "__main__":
 
 	command_groups = OrderedDict()
 	instance_commands = set()
+	type_groups = {}
 
 	for feature in spec.findall('feature'):
 		api = feature.get('api')
@@ -96,6 +421,8 @@ if __name__ == "__main__":
 		key = defined(name)
 		cmdrefs = feature.findall('require/command')
 		command_groups.setdefault(key, []).extend([cmdref.get('name') for cmdref in cmdrefs])
+		for typeref in feature.findall('require/type'):
+			type_groups.setdefault(typeref.get('name'), set()).add(key)
 
 	for ext in sorted(spec.findall('extensions/extension'), key=lambda ext: ext.get('name')):
 		supported = ext.get('supported')
@@ -103,6 +430,9 @@ if __name__ == "__main__":
 			continue
 		name = ext.get('name')
 		type = ext.get('type')
+		# types are defined by the extension block of the header, regardless of the dependencies of the commands
+		for typeref in ext.findall('require/type'):
+			type_groups.setdefault(typeref.get('name'), set()).add(defined(name))
 		for req in ext.findall('require'):
 			key = defined(name)
 			if req.get('feature'): # old-style XML depends specification
@@ -165,6 +495,17 @@ if __name__ == "__main__":
 	devp = {}
 	instp = {}
 
+	loads = {key: [] for key in load_keys}
+
+	hot = {'INSTANCE': [], 'DEVICE': []}
+	hot_pattern = re.compile('|'.join(hot_device_commands) if hot_device_table else '$^')
+
+	# hot commands are sorted by rank, keeping the original order for commands with the same rank; None keeps the command in its group
+	def hot_rank(key, name):
+		if profile is not None:
+			return -profile[name] if profile.get(name, 0) > 0 else None
+		return 0 if key == 'DEVICE' and hot_pattern.fullmatch(name) else None
+
 	for (group, cmdnames) in command_groups.items():
 		ifdef = '#if ' + group + '\n'
 
@@ -176,6 +517,8 @@ if __name__ == "__main__":
 		instt = 0
 		insto = len(blocks['INSTANCE_TABLE'])
 
+		loadcmds = {key: [] for key in load_keys}
+
 		for name in sorted(cmdnames):
 			cmd = commands[name]
 			type = cmd.findtext('param[1]/type')
@@ -186,29 +529,33 @@ if __name__ == "__main__":
 				type = 'VkInstance'
 
 			extern_fn = 'extern PFN_' + name + ' ' + name + ';\n'
-			load_fn = '\t' + name + ' = (PFN_' + name + ')load(context, "' + name + '");\n'
 			def_table = '\tPFN_' + name + ' ' + name + ';\n'
-			load_table = '\ttable->' + name + ' = (PFN_' + name + ')load(context, "' + name + '");\n'
 
 			if is_descendant_type(types, type, 'VkDevice') and name not in instance_commands:
-				blocks['LOAD_DEVICE'] += load_fn
-				blocks['DEVICE_TABLE'] += def_table
-				blocks['LOAD_DEVICE_TABLE'] += load_table
+				rank = hot_rank('DEVICE', name)
+				if rank is None:
+					loadcmds['DEVICE'].append(name)
+					blocks['DEVICE_TABLE'] += def_table
+					devt += 1
+				else:
+					hot['DEVICE'].append((rank, len(hot['DEVICE']), group, name))
 				blocks['PROTOTYPES_H_DEVICE'] += extern_fn
-				devt += 1
 			elif is_descendant_type(types, type, 'VkInstance'):
-				blocks['LOAD_INSTANCE'] += load_fn
+				rank = hot_rank('INSTANCE', name)
+				if rank is None:
+					loadcmds['INSTANCE'].append(name)
+					blocks['INSTANCE_TABLE'] += def_table
+					instt += 1
+				else:
+					hot['INSTANCE'].append((rank, len(hot['INSTANCE']), group, name))
 				blocks['PROTOTYPES_H'] += extern_fn
-				blocks['INSTANCE_TABLE'] += def_table
-				blocks['LOAD_INSTANCE_TABLE'] += load_table
-				instt += 1
 			elif type != '':
-				blocks['LOAD_LOADER'] += load_fn
+				loadcmds['LOADER'].append(name)
 				blocks['PROTOTYPES_H'] += extern_fn
 			else:
 				blocks['PROTOTYPES_H'] += extern_fn
 
-			blocks['PROTOTYPES_C'] += 'PFN_' + name + ' ' + name + ';\n'
+			blocks['PROTOTYPES_C'] += 'VOLK_GLOBAL PFN_' + name + ' ' + name + ';\n'
 
 		for key in block_keys:
 			if blocks[key].endswith(ifdef):
@@ -232,6 +579,314 @@ if __name__ == "__main__":
 			else:
 				blocks[key] += '#endif /* ' + group + ' */\n'
 
+		for key in load_keys:
+			if loadcmds[key]:
+				loads[key].append((group, loadcmds[key]))
+
+	# hot commands are placed before all other commands; consecutive commands from the same group share an #if block, so groups may be repeated with separate padding
+	for (key, padding) in (('INSTANCE', instp), ('DEVICE', devp)):
+		runs = []
+
+		for (rank, index, group, name) in sorted(hot[key]):
+			if runs and runs[-1][0] == group:
+				runs[-1][1].append(name)
+			else:
+				runs.append((group, [name]))
+
+		hot_table = ''
+
+		for (group, cmdnames) in runs:
+			hot_fields = ''.join(['\tPFN_' + name + ' ' + name + ';\n' for name in cmdnames])
+			hoth = zlib.crc32(hot_fields.encode())
+			assert(hoth not in padding)
+			padding[hoth] = True
+
+			hot_table += '#if ' + group + '\n' + hot_fields
+			hot_table += '#else\n'
+			hot_table += f'\tPFN_vkVoidFunction padding_{hoth:x}[{len(cmdnames)}];\n'
+			hot_table += '#endif /* ' + group + ' */\n'
+
+		blocks[key + '_TABLE'] = hot_table + blocks[key + '_TABLE']
+		loads[key] = runs + loads[key]
+
+	# all entrypoint names are packed into a single string blob; descriptors refer to names by offset
+	names = {}
+	nameo = 0
+	blocks['LOAD_NAMES'] = ''
+
+	for key in load_keys:
+		for (group, cmdnames) in loads[key]:
+			for name in cmdnames:
+				names[name] = nameo
+				nameo += len(name) + 1
+				blocks['LOAD_NAMES'] += '\t"' + name + '\\0"\n'
+
+	# extensions and core versions that device command groups depend on, sorted by name for binary search at runtime
+	features = sorted(set([name for (group, cmdnames) in loads['DEVICE'] for name in re.findall(r'defined\((\w+)\)', group)]))
+	blocks['LOAD_FEATURES'] = ''
+
+	for name in features:
+		core = re.match(r'VK_VERSION_(\d+)_(\d+)$', name)
+		apiversion = (int(core.group(1)) << 22) | (int(core.group(2)) << 12) if core else 0
+		blocks['LOAD_FEATURES'] += f'\t{{ {nameo}, {apiversion} }},\n'
+		nameo += len(name) + 1
+		blocks['LOAD_NAMES'] += '\t"' + name + '\\0"\n'
+
+	assert(nameo < 65536)
+
+	# extensions that command groups depend on; with VOLK_EXTENSION_ALLOWLIST, volk.c hides the ones without VOLK_ONLY_<name> so that their groups compile out
+	extensions = sorted(set([name for key in load_keys for (group, cmdnames) in loads[key] for name in re.findall(r'defined\((\w+)\)', group) if not name.startswith('VK_VERSION_')]))
+	blocks['EXTENSION_ALLOWLIST'] = '#ifdef VOLK_EXTENSION_ALLOWLIST\n'
+
+	for name in extensions:
+		blocks['EXTENSION_ALLOWLIST'] += '#ifndef VOLK_ONLY_' + name + '\n#undef ' + name + '\n#endif\n'
+
+	blocks['EXTENSION_ALLOWLIST'] += '#endif\n'
+	assert(len(features) < 0xfff0)
+
+	# custom device table only includes the selected commands, using the same group structure as the full device table
+	device_commands = set([name for (group, cmdnames) in loads['DEVICE'] for name in cmdnames])
+	unknown_commands = [name for name in custom_device_commands if name not in device_commands]
+
+	if unknown_commands or not custom_device_commands:
+		sys.exit('custom device table must be a non-empty list of device commands; unknown commands: ' + ', '.join(unknown_commands))
+
+	blocks['CUSTOM_DEVICE_TABLE'] = ''
+	custom_entries = ''
+	custom_groups = ''
+	custom_padding = {}
+	slot = 0
+
+	for (group, cmdnames) in loads['DEVICE']:
+		cmdnames = [name for name in cmdnames if name in custom_device_commands]
+		if not cmdnames:
+			continue
+
+		fields = ''.join(['\tPFN_' + name + ' ' + name + ';\n' for name in cmdnames])
+		padh = zlib.crc32(fields.encode())
+		assert(padh not in custom_padding)
+		custom_padding[padh] = True
+
+		blocks['CUSTOM_DEVICE_TABLE'] += '#if ' + group + '\n' + fields
+		blocks['CUSTOM_DEVICE_TABLE'] += '#else\n'
+		blocks['CUSTOM_DEVICE_TABLE'] += f'\tPFN_vkVoidFunction padding_{padh:x}[{len(cmdnames)}];\n'
+		blocks['CUSTOM_DEVICE_TABLE'] += '#endif /* ' + group + ' */\n'
+
+		custom_groups += '#if ' + group + '\n'
+		custom_groups += f'\t{{ {slot}, {len(cmdnames)} }},\n'
+		custom_groups += '#else\n'
+		custom_groups += f'\t{{ {slot}, 0 }},\n'
+		custom_groups += '#endif /* ' + group + ' */\n'
+
+		for name in cmdnames:
+			custom_entries += f'\t{{ {slot}, {names[name]} }},\n'
+			slot += 1
+
+	blocks['LOAD_CUSTOM_DEVICE'] = 'static const struct VolkLoadEntry volkGenCustomDeviceEntries[] =\n{\n' + custom_entries + '};\n\n'
+	blocks['LOAD_CUSTOM_DEVICE'] += 'static const struct VolkLoadGroup volkGenCustomDeviceGroups[] =\n{\n' + custom_groups + '};\n'
+
+	# captured device commands are serialized using descriptors of their parameters and of the structures they point to; fields refer to other fields and structures by index
+	(param_structs, param_commands) = parse_params(spec, type_groups, commands, [name for (group, cmdnames) in loads['DEVICE'] for name in cmdnames])
+	param_index = {name: i for (i, name) in enumerate(param_structs.keys())}
+	param_first = {}
+	param_count = 0
+
+	for (name, struct) in param_structs.items():
+		param_first[name] = param_count
+		param_count += len(struct['fields'])
+
+	def param_field(field, offset, first):
+		flags = list(field['flags'])
+		length = '0'
+		if field['length'] and field['length'][0] == 'const':
+			flags.append('VOLK_PARAM_CONSTANT')
+			length = field['length'][1]
+		elif field['length']:
+			length = str(first + field['length'][1])
+		member = str(param_first[field['member'][0]] + field['member'][1]) if field['member'] else 'VOLK_PARAM_NONE'
+		struct = str(param_index[field['struct']]) if field['struct'] else '0'
+		return f'\t{{ {offset}, {field["size"]}, VOLK_PARAM_{field["kind"]}, {" | ".join(flags) or "0"}, {field["shift"]}, {field["round"]}, {struct}, {length}, {member} }},\n'
+
+	def param_padding(count):
+		return ''.join(['\t' + ' '.join(['{ 0 },'] * len(range(i, min(i + 8, count)))) + '\n' for i in range(0, count, 8)])
+
+	param_structs_rows = ''
+	param_fields = ''
+	runs = []
+
+	# consecutive structures that are defined under the same condition share an #if block
+	for (name, struct) in param_structs.items():
+		if runs and runs[-1][0] == struct['group']:
+			runs[-1][1].append(name)
+		else:
+			runs.append((struct['group'], [name]))
+
+	for (group, structnames) in runs:
+		param_structs_rows += '#if ' + group + '\n'
+		param_structs_rows += ''.join([f'\t{{ {param_structs[name]["sType"]}, sizeof({name}), {param_first[name]}, {len(param_structs[name]["fields"])} }},\n' for name in structnames])
+		param_structs_rows += '#else\n'
+		param_structs_rows += ''.join([f'\t{{ 0, 0, {param_first[name]}, {len(param_structs[name]["fields"])} }},\n' for name in structnames])
+		param_structs_rows += '#endif /* ' + group + ' */\n'
+
+		param_fields += '#if ' + group + '\n'
+		param_fields += ''.join([param_field(field, f'offsetof({name}, {field["name"]})', param_first[name]) for name in structnames for field in param_structs[name]['fields']])
+		param_fields += '#else\n'
+		param_fields += param_padding(sum([len(param_structs[name]['fields']) for name in structnames]))
+		param_fields += '#endif /* ' + group + ' */\n'
+
+	param_device = ''
+
+	for (group, cmdnames) in loads['DEVICE']:
+		group_fields = ''
+		group_count = 0
+
+		param_device += '#if ' + group + '\n'
+
+		for name in cmdnames:
+			fields = param_commands.get(name)
+			if fields is None:
+				param_device += '\t{ 0, VOLK_PARAM_NONE },\n'
+				continue
+			# arguments are passed in 8-byte slots, so the offset of a parameter is 8 times its index
+			param_device += f'\tVOLK_PARAMS(PFN_{name}, {param_count}, {len(fields)}),\n'
+			group_fields += ''.join([param_field(field, str(8 * i), param_count) for (i, field) in enumerate(fields)])
+			param_count += len(fields)
+			group_count += len(fields)
+
+		param_device += '#else\n'
+		param_device += ''.join(['\t' + ' '.join(['{ 0, VOLK_PARAM_NONE },'] * len(cmdnames[i:i+8])) + '\n' for i in range(0, len(cmdnames), 8)])
+		param_device += '#endif /* ' + group + ' */\n'
+
+		if group_count:
+			param_fields += '#if ' + group + '\n' + group_fields + '#else\n' + param_padding(group_count) + '#endif /* ' + group + ' */\n'
+
+	assert(param_count < 65535 and len(param_structs) < 65535)
+
+	# each set of entrypoints gets a descriptor array, a per-group availability array and an array of global pointer addresses
+	for key in load_keys:
+		prefix = 'volkGen' + key.capitalize()
+		entries = ''
+		groups = ''
+		pointers = ''
+		stubs = ''
+		instrument_stubs = ''
+		replay_stubs = ''
+		stream_stubs = ''
+		slot = 0
+
+		for (group, cmdnames) in loads[key]:
+			groups += '#if ' + group + '\n'
+			groups += f'\t{{ {slot}, {len(cmdnames)} }},\n'
+			groups += '#else\n'
+			groups += f'\t{{ {slot}, 0 }},\n'
+			groups += '#endif /* ' + group + ' */\n'
+
+			pointers += '#if ' + group + '\n'
+			pointers += ''.join(['\t&' + name + ',\n' for name in cmdnames])
+			pointers += '#else\n'
+			pointers += ''.join(['\t' + ' '.join(['NULL,'] * len(cmdnames[i:i+16])) + '\n' for i in range(0, len(cmdnames), 16)])
+			pointers += '#endif /* ' + group + ' */\n'
+
+			stubs += '#if ' + group + '\n'
+			stubs += ''.join([f'\t(PFN_vkVoidFunction)VolkLazyStub<PFN_{name}, {load_keys.index(key)}, {slot + i}>::call,\n' for (i, name) in enumerate(cmdnames)])
+			stubs += '#else\n'
+			stubs += ''.join(['\t' + ' '.join(['NULL,'] * len(cmdnames[i:i+16])) + '\n' for i in range(0, len(cmdnames), 16)])
+			stubs += '#endif /* ' + group + ' */\n'
+
+			# destroying an instance or device through a table releases the instrumented copy of that table
+			instrument_stubs += '#if ' + group + '\n'
+			instrument_stubs += ''.join([f'\tVOLK_INSTRUMENT_{"RELEASE_" if name in ["vkDestroyInstance", "vkDestroyDevice"] else ""}STUBS(PFN_{name}, {load_keys.index(key)}, {slot + i}),\n' for (i, name) in enumerate(cmdnames)])
+			instrument_stubs += '#else\n'
+			instrument_stubs += ''.join(['\t' + ' '.join(['{ NULL, NULL },'] * len(cmdnames[i:i+8])) + '\n' for i in range(0, len(cmdnames), 8)])
+			instrument_stubs += '#endif /* ' + group + ' */\n'
+
+			replay_stubs += '#if ' + group + '\n'
+			replay_stubs += ''.join([f'\tVOLK_INSTRUMENT_REPLAY(PFN_{name}),\n' for name in cmdnames])
+			replay_stubs += '#else\n'
+			replay_stubs += ''.join(['\t' + ' '.join(['NULL,'] * len(cmdnames[i:i+16])) + '\n' for i in range(0, len(cmdnames), 16)])
+			replay_stubs += '#endif /* ' + group + ' */\n'
+
+			stream_stubs += '#if ' + group + '\n'
+			stream_stubs += ''.join([f'\tVOLK_COMMAND_STREAM_STUBS(PFN_{name}, {slot + i}),\n' if name.startswith('vkCmd') else '\t{ NULL, NULL },\n' for (i, name) in enumerate(cmdnames)])
+			stream_stubs += '#else\n'
+			stream_stubs += ''.join(['\t' + ' '.join(['{ NULL, NULL },'] * len(cmdnames[i:i+8])) + '\n' for i in range(0, len(cmdnames), 8)])
+			stream_stubs += '#endif /* ' + group + ' */\n'
+
+			for name in cmdnames:
+				entries += f'\t{{ {slot}, {names[name]} }},\n'
+				slot += 1
+
+		assert(slot < 65536)
+
+		blocks['LOAD_' + key] = 'static const struct VolkLoadEntry ' + prefix + 'Entries[] =\n{\n' + entries + '};\n\n'
+		blocks['LOAD_' + key] += 'static const struct VolkLoadGroup ' + prefix + 'Groups[] =\n{\n' + groups + '};\n\n'
+		blocks['LOAD_' + key] += 'static void* const ' + prefix + 'Globals[] =\n{\n' + pointers + '};\n'
+
+		# device command groups also get their #if condition in postfix form to be able to skip groups that the device doesn't support
+		if key == 'DEVICE':
+			requirements = ''.join(['\t' + ', '.join([str(c) for c in parse_requirements(group, features)] + ['VOLK_REQUIRE_END']) + ',\n' for (group, cmdnames) in loads[key]])
+			blocks['LOAD_' + key] += '\nstatic const uint16_t ' + prefix + 'Requirements[] =\n{\n' + requirements + '};\n'
+
+		# global loader functions are resolved eagerly; instance and device functions can be resolved on first call
+		if key != 'LOADER':
+			blocks['LOAD_' + key] += '\n#ifdef VOLK_LAZY\n'
+			blocks['LOAD_' + key] += 'static const PFN_vkVoidFunction ' + prefix + 'Lazy[] =\n{\n' + stubs + '};\n'
+			blocks['LOAD_' + key] += '#endif\n'
+
+			# profiling stubs count calls and forward them to the loaded function; the first stub replaces a global pointer, the second one a table entry
+			blocks['LOAD_' + key] += '\n#ifdef VOLK_INSTRUMENT\n'
+			blocks['LOAD_' + key] += 'static const PFN_vkVoidFunction ' + prefix + 'Instrument[][2] =\n{\n' + instrument_stubs + '};\n'
+			blocks['LOAD_' + key] += '#endif\n'
+
+		# captured device commands are serialized using parameter descriptors and replayed through thunks that unpack the arguments;
+		# command streams use the same descriptors to copy the data that arguments point to
+		if key == 'DEVICE':
+			blocks['PARAMS'] = '#define VOLK_PARAM_DESCRIPTORS\n\n'
+			blocks['PARAMS'] += 'static const struct VolkParamStruct volkGenParamStructs[] =\n{\n' + param_structs_rows + '};\n\n'
+			blocks['PARAMS'] += 'static const struct VolkParamField volkGenParamFields[] =\n{\n' + param_fields + '};\n\n'
+			blocks['PARAMS'] += 'static const struct VolkParamCommand ' + prefix + 'Params[] =\n{\n' + param_device + '};\n'
+
+			blocks['LOAD_' + key] += '\n#if defined(VOLK_INSTRUMENT) && defined(VOLK_INSTRUMENT_CAPTURE)\n'
+			blocks['LOAD_' + key] += 'static int32_t (* const ' + prefix + 'Replay[])(PFN_vkVoidFunction, const uint64_t*) =\n{\n' + replay_stubs + '};\n'
+			blocks['LOAD_' + key] += '#endif\n'
+
+			# vkCmd* commands can be recorded into a command stream; the first stub records the command, the second one replays it into a command buffer
+			blocks['LOAD_' + key] += '\n#ifdef VOLK_COMMAND_STREAM\n'
+			blocks['LOAD_' + key] += 'static const PFN_vkVoidFunction ' + prefix + 'Stream[][2] =\n{\n' + stream_stubs + '};\n'
+			blocks['LOAD_' + key] += '#endif\n'
+
+	# every device command gets a volk* function that calls the table registered for the dispatchable handle passed as the first argument,
+	# and a member function of the C++ dispatch class that calls the function in its table
+	blocks['REGISTRY_PROTOTYPES_H'] = '#define VOLK_REGISTRY_FUNCTIONS\n'
+	blocks['REGISTRY_C'] = ''
+	blocks['DEVICE_DISPATCH'] = '#define VOLK_DISPATCH_FUNCTIONS\n'
+
+	for (group, cmdnames) in loads['DEVICE']:
+		for key in ('REGISTRY_PROTOTYPES_H', 'REGISTRY_C', 'DEVICE_DISPATCH'):
+			blocks[key] += '#if ' + group + '\n'
+
+		for name in cmdnames:
+			cmd = commands[name]
+			params = api_filter(cmd.findall('param'))
+			result = declaration(cmd.find('proto'))[0].strip()
+			failure = {'void': 'return;', 'VkResult': 'return VK_ERROR_INITIALIZATION_FAILED;'}.get(result, 'return 0;')
+			decls = []
+			for param in params:
+				(before, after) = declaration(param)
+				decls.append(re.sub(r'\s+', ' ', before).strip() + ' ' + param.findtext('name') + after.strip())
+			args = '(' + ', '.join([param.findtext('name') for param in params]) + ')'
+			signature = 'VKAPI_ATTR ' + result + ' VKAPI_CALL volk' + name[2:] + '(' + ', '.join(decls) + ')'
+
+			blocks['REGISTRY_PROTOTYPES_H'] += signature + ';\n'
+			blocks['REGISTRY_C'] += signature + '\n{\n'
+			blocks['REGISTRY_C'] += '\tconst struct VolkDeviceTable* table = volkRegistryFind(' + params[0].findtext('name') + ');\n'
+			blocks['REGISTRY_C'] += '\tif (!table || !table->' + name + ')\n\t\t' + failure + '\n'
+			blocks['REGISTRY_C'] += '\t' + ('' if result == 'void' else 'return ') + 'table->' + name + args + ';\n}\n'
+			blocks['DEVICE_DISPATCH'] += '\tVOLK_FORCEINLINE ' + result + ' ' + name + '(' + ', '.join(decls) + ') const noexcept { VOLK_DISPATCH_CALL(' + name + ', ' + args + '); }\n'
+
+		for key in ('REGISTRY_PROTOTYPES_H', 'REGISTRY_C', 'DEVICE_DISPATCH'):
+			blocks[key] += '#endif /* ' + group + ' */\n'
+
 	patch_file('volk.h', blocks)
 	patch_file('volk.c', blocks)
 	patch_file('CMakeLists.txt', blocks)
@@ -0,0 +1,288 @@
+/* Measures the cost of calling Vulkan commands through the different kinds of function pointers volk provides,
+ * using the no-op commands of the mock loader from mock_vulkan.c:
+ * - trampoline: global function pointers loaded with volkLoadInstance, which point to loader trampolines
+ * - globals: global function pointers loaded with volkLoadDevice, which point to driver functions
+ * - table: function pointers in a VolkDeviceTable loaded with volkLoadDeviceTable
+ * - sealed: function pointers in a read-only VolkDeviceTable allocated with volkAllocateSealedDeviceTable
+ * - dispatch: member functions of volk::DeviceDispatch copied from the table (only in the C++ build, which defines VOLK_DEVICE_DISPATCH, and only if generate.py has emitted the functions)
+ * - registry: volk* functions generated for VOLK_DEVICE_REGISTRY, which look up the table registered for the command buffer
+ *   (only in the C++ build, which compiles volk.c with VOLK_DEVICE_REGISTRY, and only if generate.py has emitted the functions)
+ *
+ * This file is also compiled as C++ with VOLK_NAMESPACE (see bench_dispatch.cpp); hardening flags are applied per target.
+ * Usage: volk_bench_dispatch [--iterations N]
+ * Results are printed to stdout as JSON, in nanoseconds per call.
+ */
+#include "volk.h"
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef VOLK_NAMESPACE
+using namespace volk;
+#endif
+
+#ifndef BENCH_BUILD
+#define BENCH_BUILD "c"
+#endif
+
+#ifndef BENCH_HARDENING
+#define BENCH_HARDENING "none"
+#endif
+
+enum
+{
+	ModeTrampoline,
+	ModeGlobals,
+	ModeTable,
+	ModeSealed,
+#ifdef VOLK_DISPATCH_FUNCTIONS
+	ModeDispatch,
+#endif
+#ifdef VOLK_REGISTRY_FUNCTIONS
+	ModeRegistry,
+#endif
+	ModeCount
+};
+
+static const char* modeNames[] =
+{
+	"trampoline",
+	"globals",
+	"table",
+	"sealed",
+#ifdef VOLK_DISPATCH_FUNCTIONS
+	"dispatch",
+#endif
+#ifdef VOLK_REGISTRY_FUNCTIONS
+	"registry",
+#endif
+};
+
+static struct VolkDeviceTable table;
+static struct VolkDeviceTable* sealed;
+
+#ifdef VOLK_DISPATCH_FUNCTIONS
+static volk::DeviceDispatch dispatch;
+#endif
+
+static void benchDraw(int mode, VkCommandBuffer commandBuffer, int iterations)
+{
+	int i;
+
+	if (mode == ModeTable)
+		for (i = 0; i < iterations; ++i)
+			table.vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+	else if (mode == ModeSealed)
+		for (i = 0; i < iterations; ++i)
+			sealed->vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+#ifdef VOLK_DISPATCH_FUNCTIONS
+	else if (mode == ModeDispatch)
+		for (i = 0; i < iterations; ++i)
+			dispatch.vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+#endif
+#ifdef VOLK_REGISTRY_FUNCTIONS
+	else if (mode == ModeRegistry)
+		for (i = 0; i < iterations; ++i)
+			volkCmdDraw(commandBuffer, 3, 1, 0, 0);
+#endif
+	else
+		for (i = 0; i < iterations; ++i)
+			vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+static void benchBindDescriptorSets(int mode, VkCommandBuffer commandBuffer, int iterations)
+{
+	VkDescriptorSet set = VK_NULL_HANDLE;
+	int i;
+
+	if (mode == ModeTable)
+		for (i = 0; i < iterations; ++i)
+			table.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, VK_NULL_HANDLE, 0, 1, &set, 0, NULL);
+	else if (mode == ModeSealed)
+		for (i = 0; i < iterations; ++i)
+			sealed->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, VK_NULL_HANDLE, 0, 1, &set, 0, NULL);
+#ifdef VOLK_DISPATCH_FUNCTIONS
+	else if (mode == ModeDispatch)
+		for (i = 0; i < iterations; ++i)
+			dispatch.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, VK_NULL_HANDLE, 0, 1, &set, 0, NULL);
+#endif
+#ifdef VOLK_REGISTRY_FUNCTIONS
+	else if (mode == ModeRegistry)
+		for (i = 0; i < iterations; ++i)
+			volkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, VK_NULL_HANDLE, 0, 1, &set, 0, NULL);
+#endif
+	else
+		for (i = 0; i < iterations; ++i)
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, VK_NULL_HANDLE, 0, 1, &set, 0, NULL);
+}
+
+#if defined(VK_VERSION_1_3)
+static void benchPipelineBarrier2(int mode, VkCommandBuffer commandBuffer, int iterations)
+{
+	VkDependencyInfo dependency;
+	int i;
+
+	memset(&dependency, 0, sizeof(dependency));
+	dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+
+	if (mode == ModeTable)
+		for (i = 0; i < iterations; ++i)
+			table.vkCmdPipelineBarrier2(commandBuffer, &dependency);
+	else if (mode == ModeSealed)
+		for (i = 0; i < iterations; ++i)
+			sealed->vkCmdPipelineBarrier2(commandBuffer, &dependency);
+#ifdef VOLK_DISPATCH_FUNCTIONS
+	else if (mode == ModeDispatch)
+		for (i = 0; i < iterations; ++i)
+			dispatch.vkCmdPipelineBarrier2(commandBuffer, &dependency);
+#endif
+#ifdef VOLK_REGISTRY_FUNCTIONS
+	else if (mode == ModeRegistry)
+		for (i = 0; i < iterations; ++i)
+			volkCmdPipelineBarrier2(commandBuffer, &dependency);
+#endif
+	else
+		for (i = 0; i < iterations; ++i)
+			vkCmdPipelineBarrier2(commandBuffer, &dependency);
+}
+#endif
+
+struct Command
+{
+	const char* name;
+	void (*run)(int mode, VkCommandBuffer commandBuffer, int iterations);
+};
+
+static const struct Command commands[] =
+{
+	{ "vkCmdDraw", benchDraw },
+	{ "vkCmdBindDescriptorSets", benchBindDescriptorSets },
+#if defined(VK_VERSION_1_3)
+	{ "vkCmdPipelineBarrier2", benchPipelineBarrier2 },
+#endif
+};
+
+static double measure(const struct Command* command, int mode, VkCommandBuffer commandBuffer, int iterations)
+{
+	uint64_t best = ~0ull;
+	int run;
+
+	/* warm up caches and branch predictors, then take the fastest of several runs to reduce noise */
+	command->run(mode, commandBuffer, iterations / 10);
+
+	for (run = 0; run < 5; ++run)
+	{
+		uint64_t start, time;
+
+		start = benchTime();
+		command->run(mode, commandBuffer, iterations);
+		time = benchTime() - start;
+
+		best = time < best ? time : best;
+	}
+
+	return (double)best / iterations;
+}
+
+int main(int argc, char** argv)
+{
+	/* the mock doesn't dereference the instance and device handles */
+	VkInstance instance = (VkInstance)&table;
+	VkDevice device = (VkDevice)&table;
+	VkCommandBufferAllocateInfo allocateInfo;
+	VkCommandBuffer commandBuffer;
+	double results[ModeCount][sizeof(commands) / sizeof(commands[0])];
+	int iterations = 10000000;
+	size_t i;
+	int mode;
+
+	if (argc == 3 && strcmp(argv[1], "--iterations") == 0)
+		iterations = atoi(argv[2]);
+
+	if ((argc != 1 && argc != 3) || iterations < 10)
+	{
+		fprintf(stderr, "Usage: %s [--iterations N]\n", argv[0]);
+		return 1;
+	}
+
+	if (volkInitialize() != VK_SUCCESS)
+	{
+		fprintf(stderr, "volkInitialize failed; make sure the mock loader is next to the executable\n");
+		return 1;
+	}
+
+	for (mode = 0; mode < ModeCount; ++mode)
+	{
+		if (mode == ModeTrampoline)
+			volkLoadInstance(instance);
+		else if (mode == ModeGlobals)
+			volkLoadDevice(device);
+		else if (mode == ModeTable)
+			volkLoadDeviceTable(&table, device);
+		else if (mode == ModeSealed)
+		{
+			sealed = volkAllocateSealedDeviceTable();
+
+			if (!sealed)
+				return 1;
+
+			volkLoadDeviceTable(sealed, device);
+
+			if (volkSealDeviceTable(sealed) != VK_SUCCESS)
+				return 1;
+		}
+#ifdef VOLK_DISPATCH_FUNCTIONS
+		else if (mode == ModeDispatch)
+			dispatch = volk::DeviceDispatch(table);
+#endif
+
+		memset(&allocateInfo, 0, sizeof(allocateInfo));
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocateInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(device, &allocateInfo, &commandBuffer) != VK_SUCCESS)
+			return 1;
+
+#ifdef VOLK_REGISTRY_FUNCTIONS
+		/* the registry is keyed by the loader dispatch pointer, which the device shares with its command buffers */
+		if (mode == ModeRegistry)
+		{
+			void* registryDevice = *(void**)commandBuffer;
+
+			if (volkRegisterDevice(&table, (VkDevice)&registryDevice) != VK_SUCCESS)
+				return 1;
+		}
+#endif
+
+		for (i = 0; i < sizeof(commands) / sizeof(commands[0]); ++i)
+			results[mode][i] = measure(&commands[i], mode, commandBuffer, iterations);
+	}
+
+	printf("{\n");
+	printf("\t\"benchmark\": \"volk_bench_dispatch\",\n");
+	printf("\t\"build\": \"%s\",\n", BENCH_BUILD);
+	printf("\t\"hardening\": \"%s\",\n", BENCH_HARDENING);
+	printf("\t\"iterations\": %d,\n", iterations);
+	printf("\t\"ns_per_call\": {\n");
+
+	for (mode = 0; mode < ModeCount; ++mode)
+	{
+		printf("\t\t\"%s\": {", modeNames[mode]);
+
+		for (i = 0; i < sizeof(commands) / sizeof(commands[0]); ++i)
+			printf("%s \"%s\": %.3f", i == 0 ? "" : ",", commands[i].name, results[mode][i]);
+
+		printf(" }%s\n", mode + 1 < ModeCount ? "," : "");
+	}
+
+	printf("\t}\n");
+	printf("}\n");
+
+	volkFreeSealedDeviceTable(sealed);
+	volkFinalize();
+	return 0;
+}
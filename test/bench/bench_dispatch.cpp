@@ -0,0 +1,2 @@
+/* C++ build of the dispatch benchmark, used together with volk_namespace.cpp to measure VOLK_NAMESPACE mode */
+#include "bench_dispatch.c"
@@ -0,0 +1,203 @@
+/* Measures the time volk spends loading the Vulkan loader and entrypoints, using the mock loader from mock_vulkan.c.
+ * The volkLoadDeviceTableAsync phase measures the time until the priority commands can be called.
+ * The volkLoadDeviceTables phase loads tables for 8 devices that share the driver, and their contents are checked against the single table.
+ * The volkInternDeviceTable phase interns the synchronously loaded table; the asynchronously loaded table must be identical and share the interned copy.
+ *
+ * Usage: volk_bench_load [--iterations N] [--latency NS] [--null-ratio R] [--layers N] [--driver PATH | --async]
+ * With --driver, the mock is loaded as a driver via volkInitializeDirectDriver from the given manifest or library path.
+ * With --async, the mock is loaded via volkInitializeAsync and volkWaitInitialized, which also enumerate instance extensions.
+ * Results are printed to stdout as JSON.
+ */
+#include "volk.h"
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum
+{
+	PhaseInitialize,
+	PhaseLoadInstance,
+	PhaseLoadDevice,
+	PhaseLoadDeviceTable,
+	PhaseLoadDeviceTableAsync,
+	PhaseLoadDeviceTables,
+	PhaseInternDeviceTable,
+	PhaseCount
+};
+
+static const char* phaseNames[PhaseCount] = { "volkInitialize", "volkLoadInstance", "volkLoadDevice", "volkLoadDeviceTable", "volkLoadDeviceTableAsync", "volkLoadDeviceTables", "volkInternDeviceTable" };
+
+/* commands that applications typically need right after creating the device */
+static const char* priorityCommands[] = { "vkGetDeviceQueue", "vkCreateSwapchainKHR", "vkGetSwapchainImagesKHR", "vkCreateBuffer", "vkCreateImage", "vkAllocateMemory" };
+
+static void setConfig(const char* name, const char* value)
+{
+#if defined(_WIN32)
+	_putenv_s(name, value);
+#else
+	setenv(name, value, 1);
+#endif
+}
+
+static int compareTimes(const void* lhs, const void* rhs)
+{
+	uint64_t l = *(const uint64_t*)lhs, r = *(const uint64_t*)rhs;
+	return l < r ? -1 : l > r;
+}
+
+int main(int argc, char** argv)
+{
+	static struct VolkDeviceTable table;
+	static struct VolkDeviceTable asyncTable;
+	static struct VolkDeviceTable batchTables[8];
+	VkDevice batchDevices[8];
+	const char* latency = "0";
+	const char* ratio = "0";
+	const char* layers = "0";
+	const char* driver = NULL;
+	int async = 0;
+	int iterations = 20;
+	uint64_t* times;
+	int i, phase;
+
+	for (i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--async") == 0)
+			async = 1;
+		else if (i + 1 == argc)
+			break;
+		else if (strcmp(argv[i], "--iterations") == 0)
+			iterations = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--latency") == 0)
+			latency = argv[++i];
+		else if (strcmp(argv[i], "--null-ratio") == 0)
+			ratio = argv[++i];
+		else if (strcmp(argv[i], "--layers") == 0)
+			layers = argv[++i];
+		else if (strcmp(argv[i], "--driver") == 0)
+			driver = argv[++i];
+		else
+			break;
+	}
+
+	if (i < argc || iterations <= 0 || (async && driver))
+	{
+		fprintf(stderr, "Usage: %s [--iterations N] [--latency NS] [--null-ratio R] [--layers N] [--driver PATH | --async]\n", argv[0]);
+		return 1;
+	}
+
+	/* the mock loader reads its configuration when it's loaded by volkInitialize */
+	setConfig("VOLK_MOCK_LATENCY_NS", latency);
+	setConfig("VOLK_MOCK_NULL_RATIO", ratio);
+	setConfig("VOLK_MOCK_LAYERS", layers);
+
+	times = (uint64_t*)calloc((size_t)iterations * PhaseCount, sizeof(uint64_t));
+
+	for (i = 0; i < iterations; ++i)
+	{
+		/* the mock doesn't dereference the handles */
+		VkInstance instance = (VkInstance)&table;
+		VkDevice device = (VkDevice)&table;
+		struct VolkDeviceTableLoad* load;
+		const struct VolkDeviceTable* interned;
+		const struct VolkDeviceTable* asyncInterned;
+		uint32_t j;
+		uint64_t t0, t1, t2, t3, t4, t5, t6, t7, t8;
+
+		t0 = benchTime();
+		if (async)
+		{
+			uint32_t extensionCount = 0;
+
+			volkInitializeAsync(VK_TRUE);
+
+			if (volkWaitInitialized() != VK_SUCCESS || volkGetInstanceExtensionProperties(&extensionCount, NULL) != VK_SUCCESS || extensionCount == 0)
+			{
+				fprintf(stderr, "volkInitializeAsync failed; make sure the mock loader is next to the executable\n");
+				return 1;
+			}
+		}
+		else if ((driver ? volkInitializeDirectDriver(driver) : volkInitialize()) != VK_SUCCESS)
+		{
+			fprintf(stderr, "%s failed; make sure the mock loader is next to the executable\n", driver ? "volkInitializeDirectDriver" : "volkInitialize");
+			return 1;
+		}
+		t1 = benchTime();
+		volkLoadInstance(instance);
+		t2 = benchTime();
+		volkLoadDevice(device);
+		t3 = benchTime();
+		volkLoadDeviceTable(&table, device);
+		t4 = benchTime();
+		volkLoadDeviceTableAsync(&asyncTable, device, priorityCommands, sizeof(priorityCommands) / sizeof(priorityCommands[0]), &load);
+		t5 = benchTime();
+		volkWaitDeviceTableLoad(load);
+
+		for (j = 0; j < 8; ++j)
+			batchDevices[j] = device;
+
+		t6 = benchTime();
+		volkLoadDeviceTables(batchTables, batchDevices, 8);
+		t7 = benchTime();
+		interned = volkInternDeviceTable(&table);
+		t8 = benchTime();
+
+		for (j = 0; j < 8; ++j)
+			if (volkDiffDeviceTables(&table, &batchTables[j], NULL, NULL) != 0)
+			{
+				fprintf(stderr, "volkLoadDeviceTables loaded a different table than volkLoadDeviceTable\n");
+				return 1;
+			}
+
+		asyncInterned = volkInternDeviceTable(&asyncTable);
+
+		if (!interned || interned != asyncInterned || volkDiffDeviceTables(&table, &asyncTable, NULL, NULL) != 0)
+		{
+			fprintf(stderr, "volkLoadDeviceTableAsync loaded a different table than volkLoadDeviceTable\n");
+			return 1;
+		}
+
+		volkReleaseDeviceTable(asyncInterned);
+		volkReleaseDeviceTable(interned);
+
+		volkFinalize();
+
+		times[PhaseInitialize * iterations + i] = t1 - t0;
+		times[PhaseLoadInstance * iterations + i] = t2 - t1;
+		times[PhaseLoadDevice * iterations + i] = t3 - t2;
+		times[PhaseLoadDeviceTable * iterations + i] = t4 - t3;
+		times[PhaseLoadDeviceTableAsync * iterations + i] = t5 - t4;
+		times[PhaseLoadDeviceTables * iterations + i] = t7 - t6;
+		times[PhaseInternDeviceTable * iterations + i] = t8 - t7;
+	}
+
+	printf("{\n");
+	printf("\t\"benchmark\": \"volk_bench_load\",\n");
+	printf("\t\"volk_header_version\": %d,\n", VOLK_HEADER_VERSION);
+	printf("\t\"config\": { \"iterations\": %d, \"latency_ns\": %s, \"null_ratio\": %s, \"layers\": %s, \"direct_driver\": %s, \"async\": %s },\n", iterations, latency, ratio, layers, driver ? "true" : "false", async ? "true" : "false");
+	printf("\t\"phases\": {\n");
+
+	for (phase = 0; phase < PhaseCount; ++phase)
+	{
+		uint64_t* phaseTimes = &times[phase * iterations];
+		uint64_t total = 0;
+
+		for (i = 0; i < iterations; ++i)
+			total += phaseTimes[i];
+
+		qsort(phaseTimes, iterations, sizeof(uint64_t), compareTimes);
+
+		printf("\t\t\"%s\": { \"min_us\": %.3f, \"median_us\": %.3f, \"mean_us\": %.3f, \"max_us\": %.3f }%s\n", phaseNames[phase],
+		    phaseTimes[0] / 1e3, phaseTimes[iterations / 2] / 1e3, total / 1e3 / iterations, phaseTimes[iterations - 1] / 1e3,
+		    phase + 1 < PhaseCount ? "," : "");
+	}
+
+	printf("\t}\n");
+	printf("}\n");
+
+	free(times);
+	return 0;
+}
@@ -0,0 +1,175 @@
+/* Records a synthetic command stream to a file with volkStartCapture, then reads the file back and replays it through the mock driver
+ * with volkReplayCapture to measure the cost of individual commands.
+ *
+ * volk is compiled as C++ with VOLK_INSTRUMENT and VOLK_INSTRUMENT_CAPTURE (see volk_capture.cpp).
+ * Handles created during the capture are mapped to the handles created during replay; recording and replay happen in the same run to keep the benchmark self-contained.
+ * Usage: volk_bench_replay [--iterations N] [--capture file]
+ * Results are printed to stdout as JSON, in nanoseconds per call.
+ */
+#include "volk.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static struct VolkDeviceTable table;
+
+/* the mock doesn't dereference the instance and device handles, but instrumentation reads the dispatch pointer from them */
+static void* benchInstance = &benchInstance;
+static void* benchDevice = &benchDevice;
+
+static VkResult allocateCommandBuffer(PFN_vkAllocateCommandBuffers allocate, VkCommandBuffer* commandBuffer)
+{
+	VkCommandBufferAllocateInfo allocateInfo;
+
+	memset(&allocateInfo, 0, sizeof(allocateInfo));
+	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount = 1;
+
+	return allocate((VkDevice)&benchDevice, &allocateInfo, commandBuffer);
+}
+
+static int record(const char* path, int iterations)
+{
+	VkCommandBuffer commandBuffer;
+	VkDescriptorSet set = VK_NULL_HANDLE;
+	int i;
+
+	if (volkStartCapture(path) != VK_SUCCESS)
+	{
+		fprintf(stderr, "volkStartCapture failed\n");
+		return 1;
+	}
+
+	/* the command buffer is allocated during the capture, so that replay allocates its own command buffer and uses it for the recorded commands */
+	if (allocateCommandBuffer(table.vkAllocateCommandBuffers, &commandBuffer) != VK_SUCCESS)
+	{
+		volkStopCapture();
+		return 1;
+	}
+
+	/* structures and arrays that commands take by pointer are captured along with the calls */
+	for (i = 0; i < iterations; ++i)
+	{
+		table.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, VK_NULL_HANDLE, 0, 1, &set, 0, NULL);
+		table.vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+
+		if (table.vkCmdDispatch)
+			table.vkCmdDispatch(commandBuffer, 64, 1, 1);
+	}
+
+	return volkStopCapture() == VK_SUCCESS ? 0 : 1;
+}
+
+static int replay(const char* path)
+{
+	struct VolkCallStats* stats;
+	uint32_t statsCount = 0;
+	char* data;
+	long size;
+	uint32_t i;
+	FILE* file = fopen(path, "rb");
+
+	if (!file)
+	{
+		fprintf(stderr, "Can't open %s\n", path);
+		return 1;
+	}
+
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	data = (char*)malloc(size > 0 ? size : 1);
+	if (!data || fread(data, 1, size, file) != (size_t)size)
+	{
+		fclose(file);
+		free(data);
+		return 1;
+	}
+
+	fclose(file);
+
+	if (volkReplayCapture(&table, (VkDevice)&benchDevice, data, size, &statsCount, NULL) != VK_SUCCESS)
+	{
+		fprintf(stderr, "%s is not a valid capture\n", path);
+		free(data);
+		return 1;
+	}
+
+	/* arguments are only captured for commands that have parameter descriptors, which generate.py creates from vk.xml */
+	if (statsCount == 0)
+		fprintf(stderr, "No calls were replayed; volk.c was generated without parameter descriptors\n");
+
+	stats = (struct VolkCallStats*)calloc(statsCount + 1, sizeof(struct VolkCallStats));
+	if (!stats || volkReplayCapture(&table, (VkDevice)&benchDevice, data, size, &statsCount, stats) != VK_SUCCESS)
+	{
+		free(stats);
+		free(data);
+		return 1;
+	}
+
+	printf("{\n");
+	printf("\t\"benchmark\": \"volk_bench_replay\",\n");
+	printf("\t\"capture_bytes\": %ld,\n", size);
+	printf("\t\"ns_per_call\": {");
+
+	for (i = 0; i < statsCount; ++i)
+		printf("%s\n\t\t\"%s\": { \"count\": %llu, \"ns\": %.3f }", i == 0 ? "" : ",", stats[i].name, (unsigned long long)stats[i].count, (double)stats[i].time / (double)stats[i].count);
+
+	printf("\n\t}\n");
+	printf("}\n");
+
+	free(stats);
+	free(data);
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	const char* path = "capture.bin";
+	VkCommandBuffer commandBuffer;
+	int iterations = 1000;
+	int result;
+	int i;
+
+	for (i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--iterations") == 0)
+			iterations = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--capture") == 0)
+			path = argv[i + 1];
+		else
+			break;
+	}
+
+	if (i != argc || iterations < 1)
+	{
+		fprintf(stderr, "Usage: %s [--iterations N] [--capture file]\n", argv[0]);
+		return 1;
+	}
+
+	if (volkInitialize() != VK_SUCCESS)
+	{
+		fprintf(stderr, "volkInitialize failed; make sure the mock loader is next to the executable\n");
+		return 1;
+	}
+
+	volkLoadInstance((VkInstance)&benchInstance);
+
+	/* instrumentation finds the table of a command buffer using its dispatch pointer, which a device shares with its command buffers */
+	if (allocateCommandBuffer(vkAllocateCommandBuffers, &commandBuffer) != VK_SUCCESS)
+		return 1;
+
+	benchDevice = *(void**)commandBuffer;
+	volkLoadDeviceTable(&table, (VkDevice)&benchDevice);
+
+	result = record(path, iterations);
+
+	if (result == 0)
+		result = replay(path);
+
+	volkFinalize();
+	return result;
+}
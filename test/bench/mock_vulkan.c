@@ -0,0 +1,243 @@
+/* Mock Vulkan loader for benchmarks: serves vkGetInstanceProcAddr and vkGetDeviceProcAddr without a GPU.
+ *
+ * The behavior is configured via environment variables that are read when the library is loaded:
+ * VOLK_MOCK_LATENCY_NS: time spent in every layer (and the driver) for each lookup
+ * VOLK_MOCK_NULL_RATIO: fraction of functions, between 0 and 1, that are reported as unavailable
+ * VOLK_MOCK_LAYERS: number of layers each lookup goes through before reaching the driver
+ *
+ * Most functions returned by the lookups are no-ops. A few commands used by the dispatch benchmark are implemented
+ * similarly to a real loader and driver: vkGetDeviceProcAddr returns driver functions, and vkGetInstanceProcAddr returns
+ * trampolines that forward the call through the dispatch table stored in the command buffer.
+ *
+ * The library also exports the driver interface (vk_icdGetInstanceProcAddr and vk_icdNegotiateLoaderICDInterfaceVersion),
+ * so that it can be loaded with volkInitializeDirectDriver as well.
+ */
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan_core.h>
+
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#	define MOCK_EXPORT __declspec(dllexport)
+#else
+#	define MOCK_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* every layer compares the name against the functions it intercepts, similarly to how layers look up their dispatch entries */
+static const char* mockLayerFunctions[] =
+{
+	"vkCreateInstance",
+	"vkDestroyInstance",
+	"vkCreateDevice",
+	"vkDestroyDevice",
+	"vkQueueSubmit",
+	"vkQueuePresentKHR",
+	"vkCreateSwapchainKHR",
+	"vkAllocateMemory",
+	"vkFreeMemory",
+	"vkCreateBuffer",
+	"vkCreateImage",
+	"vkBeginCommandBuffer",
+	"vkEndCommandBuffer",
+	"vkCmdDraw",
+	"vkCmdDrawIndexed",
+	"vkCmdDispatch",
+};
+
+static int mockConfigured;
+static uint64_t mockLatency;
+static uint32_t mockNullThreshold;
+static int mockLayers;
+
+static void mockConfigure(void)
+{
+	const char* latency = getenv("VOLK_MOCK_LATENCY_NS");
+	const char* ratio = getenv("VOLK_MOCK_NULL_RATIO");
+	const char* layers = getenv("VOLK_MOCK_LAYERS");
+
+	mockLatency = latency ? strtoull(latency, NULL, 10) : 0;
+	mockNullThreshold = ratio ? (uint32_t)(atof(ratio) * 65536) : 0;
+	mockLayers = layers ? atoi(layers) : 0;
+	mockConfigured = 1;
+}
+
+static void VKAPI_CALL mockNoop(void)
+{
+}
+
+static VKAPI_ATTR void VKAPI_CALL mockCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+{
+	(void)commandBuffer;
+	(void)vertexCount;
+	(void)instanceCount;
+	(void)firstVertex;
+	(void)firstInstance;
+}
+
+static VKAPI_ATTR void VKAPI_CALL mockCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets)
+{
+	(void)commandBuffer;
+	(void)pipelineBindPoint;
+	(void)layout;
+	(void)firstSet;
+	(void)descriptorSetCount;
+	(void)pDescriptorSets;
+	(void)dynamicOffsetCount;
+	(void)pDynamicOffsets;
+}
+
+#if defined(VK_VERSION_1_3)
+static VKAPI_ATTR void VKAPI_CALL mockCmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfo* pDependencyInfo)
+{
+	(void)commandBuffer;
+	(void)pDependencyInfo;
+}
+#endif
+
+struct MockDispatch
+{
+	PFN_vkCmdDraw CmdDraw;
+	PFN_vkCmdBindDescriptorSets CmdBindDescriptorSets;
+#if defined(VK_VERSION_1_3)
+	PFN_vkCmdPipelineBarrier2 CmdPipelineBarrier2;
+#endif
+};
+
+static const struct MockDispatch mockDispatch =
+{
+	mockCmdDraw,
+	mockCmdBindDescriptorSets,
+#if defined(VK_VERSION_1_3)
+	mockCmdPipelineBarrier2,
+#endif
+};
+
+/* dispatchable handles start with a pointer to the dispatch table */
+static const struct MockDispatch* mockCommandBuffer = &mockDispatch;
+
+static VKAPI_ATTR VkResult VKAPI_CALL mockAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers)
+{
+	(void)device;
+	(void)pAllocateInfo;
+	*pCommandBuffers = (VkCommandBuffer)&mockCommandBuffer;
+	return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL mockEnumerateInstanceExtensionProperties(const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties)
+{
+	static const VkExtensionProperties extensions[] =
+	{
+		{ "VK_KHR_surface", 25 },
+		{ "VK_EXT_debug_utils", 2 },
+	};
+	uint32_t total = sizeof(extensions) / sizeof(extensions[0]);
+	uint32_t count;
+
+	if (pLayerName)
+		return VK_ERROR_LAYER_NOT_PRESENT;
+
+	if (!pProperties)
+	{
+		*pPropertyCount = total;
+		return VK_SUCCESS;
+	}
+
+	count = *pPropertyCount < total ? *pPropertyCount : total;
+	memcpy(pProperties, extensions, count * sizeof(VkExtensionProperties));
+	*pPropertyCount = count;
+
+	return count < total ? VK_INCOMPLETE : VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL trampolineCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+{
+	(*(const struct MockDispatch**)commandBuffer)->CmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+static VKAPI_ATTR void VKAPI_CALL trampolineCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets)
+{
+	(*(const struct MockDispatch**)commandBuffer)->CmdBindDescriptorSets(commandBuffer, pipelineBindPoint, layout, firstSet, descriptorSetCount, pDescriptorSets, dynamicOffsetCount, pDynamicOffsets);
+}
+
+#if defined(VK_VERSION_1_3)
+static VKAPI_ATTR void VKAPI_CALL trampolineCmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfo* pDependencyInfo)
+{
+	(*(const struct MockDispatch**)commandBuffer)->CmdPipelineBarrier2(commandBuffer, pDependencyInfo);
+}
+#endif
+
+MOCK_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(VkInstance instance, const char* pName);
+static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL mockGetDeviceProcAddr(VkDevice device, const char* pName);
+
+static PFN_vkVoidFunction mockLookup(const char* name, int device)
+{
+	uint32_t hash = 2166136261u;
+	const char* p;
+	int layer;
+	size_t i;
+
+	if (!mockConfigured)
+		mockConfigure();
+
+	for (layer = 0; layer <= mockLayers; ++layer)
+	{
+		uint64_t start = mockLatency ? benchTime() : 0;
+
+		for (i = 0; i < sizeof(mockLayerFunctions) / sizeof(mockLayerFunctions[0]) && layer < mockLayers; ++i)
+			if (strcmp(mockLayerFunctions[i], name) == 0)
+				break;
+
+		while (mockLatency && benchTime() - start < mockLatency)
+			;
+	}
+
+	if (strcmp(name, "vkGetInstanceProcAddr") == 0)
+		return (PFN_vkVoidFunction)vkGetInstanceProcAddr;
+	if (strcmp(name, "vkGetDeviceProcAddr") == 0)
+		return (PFN_vkVoidFunction)mockGetDeviceProcAddr;
+	if (strcmp(name, "vkAllocateCommandBuffers") == 0)
+		return (PFN_vkVoidFunction)mockAllocateCommandBuffers;
+	if (strcmp(name, "vkEnumerateInstanceExtensionProperties") == 0)
+		return (PFN_vkVoidFunction)mockEnumerateInstanceExtensionProperties;
+	if (strcmp(name, "vkCmdDraw") == 0)
+		return device ? (PFN_vkVoidFunction)mockCmdDraw : (PFN_vkVoidFunction)trampolineCmdDraw;
+	if (strcmp(name, "vkCmdBindDescriptorSets") == 0)
+		return device ? (PFN_vkVoidFunction)mockCmdBindDescriptorSets : (PFN_vkVoidFunction)trampolineCmdBindDescriptorSets;
+#if defined(VK_VERSION_1_3)
+	if (strcmp(name, "vkCmdPipelineBarrier2") == 0)
+		return device ? (PFN_vkVoidFunction)mockCmdPipelineBarrier2 : (PFN_vkVoidFunction)trampolineCmdPipelineBarrier2;
+#endif
+
+	/* the set of unavailable functions only depends on the name so that it's stable across runs */
+	for (p = name; *p; ++p)
+		hash = (hash ^ (unsigned char)*p) * 16777619u;
+
+	return (hash & 65535) < mockNullThreshold ? NULL : (PFN_vkVoidFunction)mockNoop;
+}
+
+MOCK_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(VkInstance instance, const char* pName)
+{
+	(void)instance;
+	return mockLookup(pName, 0);
+}
+
+static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL mockGetDeviceProcAddr(VkDevice device, const char* pName)
+{
+	(void)device;
+	return mockLookup(pName, 1);
+}
+
+MOCK_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vk_icdGetInstanceProcAddr(VkInstance instance, const char* pName)
+{
+	(void)instance;
+	return mockLookup(pName, 0);
+}
+
+MOCK_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vk_icdNegotiateLoaderICDInterfaceVersion(uint32_t* pSupportedVersion)
+{
+	/* the mock doesn't depend on the loader, so it supports any interface version starting from 2 */
+	return *pSupportedVersion >= 2 ? VK_SUCCESS : VK_ERROR_INCOMPATIBLE_DRIVER;
+}
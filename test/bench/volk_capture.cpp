@@ -0,0 +1,2 @@
+/* volk.c compiled as C++ with VOLK_INSTRUMENT and VOLK_INSTRUMENT_CAPTURE for the replay benchmark */
+#include "../../volk.c"
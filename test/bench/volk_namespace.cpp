@@ -0,0 +1,2 @@
+/* volk.c compiled as C++ with VOLK_NAMESPACE for the dispatch benchmark */
+#include "../../volk.c"
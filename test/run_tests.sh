@@ -96,5 +96,23 @@ run_volk_test
 popd
 popd
 
+echo
+echo "bench =============================================================>"
+echo
+
+pushd test/bench
+reset_build
+pushd _build
+cmake .. || exit 1
+cmake --build . || exit 1
+./volk_bench_load --iterations 3 || exit 1
+./volk_bench_load --iterations 3 --driver volk_mock_icd.json || exit 1
+./volk_bench_load --iterations 3 --async || exit 1
+./volk_bench_dispatch --iterations 1000 || exit 1
+./volk_bench_dispatch_namespace --iterations 1000 || exit 1
+./volk_bench_replay --iterations 1000 || exit 1
+popd
+popd
+
 popd
 
@@ -45,6 +45,7 @@ extern "C" {
 
 struct VolkInstanceTable;
 struct VolkDeviceTable;
+struct VolkCustomDeviceTable;
 
 /**
  * Initialize library by loading Vulkan loader; call this function before creating the Vulkan instance.
@@ -62,6 +63,50 @@ VkResult volkInitialize(void);
  */
 void volkInitializeCustom(PFN_vkGetInstanceProcAddr handler);
 
+/**
+ * Initialize library by loading a Vulkan driver (ICD) directly, without the Vulkan loader.
+ *
+ * This function can be used instead of volkInitialize.
+ * driver is either the path of an ICD manifest (.json), in which case the driver library is loaded from the library_path of its ICD object,
+ * or the path of the driver library itself. The driver is initialized via vk_icdNegotiateLoaderICDInterfaceVersion and
+ * vk_icdGetInstanceProcAddr, and all functions are loaded from the driver; layers and other drivers are not available.
+ * Returns VK_ERROR_INITIALIZATION_FAILED if the manifest or the library can't be loaded, and VK_ERROR_INCOMPATIBLE_DRIVER
+ * if the library isn't a compatible driver.
+ * All dispatchable handles of such a driver start with the same value, so volkRegisterDevice fails and tables loaded with VOLK_INSTRUMENT are not instrumented.
+ */
+VkResult volkInitializeDirectDriver(const char* driver);
+
+/**
+ * Start volkInitialize on a background thread, so that the application can do other work while the Vulkan loader is loaded.
+ *
+ * If enumerateExtensions is VK_TRUE, the thread also calls vkEnumerateInstanceExtensionProperties and caches the result for volkGetInstanceExtensionProperties.
+ * Global functions such as vkCreateInstance can only be used after volkWaitInitialized or volkPollInitialized returns VK_SUCCESS.
+ * volkWaitInitialized and volkPollInitialized must be called from the thread that called volkInitializeAsync.
+ */
+void volkInitializeAsync(VkBool32 enumerateExtensions);
+
+/**
+ * Wait for the initialization started by volkInitializeAsync to finish.
+ *
+ * Returns the result of volkInitialize, or VK_ERROR_INITIALIZATION_FAILED if volkInitializeAsync wasn't called.
+ */
+VkResult volkWaitInitialized(void);
+
+/**
+ * Check whether the initialization started by volkInitializeAsync has finished, without blocking.
+ *
+ * Returns VK_NOT_READY while the initialization is in progress, and the same value as volkWaitInitialized afterwards.
+ */
+VkResult volkPollInitialized(void);
+
+/**
+ * Get the instance extensions enumerated by volkInitializeAsync.
+ *
+ * Works like vkEnumerateInstanceExtensionProperties without a layer name, but returns the cached result.
+ * Returns VK_NOT_READY if the initialization hasn't finished yet, and VK_ERROR_INITIALIZATION_FAILED if the extensions weren't enumerated.
+ */
+VkResult volkGetInstanceExtensionProperties(uint32_t* pPropertyCount, VkExtensionProperties* pProperties);
+
 /**
  * Finalize library by unloading Vulkan loader and resetting global symbols to NULL.
  *
@@ -119,6 +164,287 @@ void volkLoadInstanceTable(struct VolkInstanceTable* table, VkInstance instance)
  */
 void volkLoadDeviceTable(struct VolkDeviceTable* table, VkDevice device);
 
+/**
+ * Load function pointers using application-created VkDevice into a table, splitting the lookups across up to workerCount threads.
+ * The resulting table is identical to the one produced by volkLoadDeviceTable; workerCount <= 1 loads the table on the calling thread.
+ */
+void volkLoadDeviceTableParallel(struct VolkDeviceTable* table, VkDevice device, uint32_t workerCount);
+
+/**
+ * Load function pointers using application-created VkDevice objects into an array of tables, one per device.
+ * Devices are grouped by the driver and layers they use; the table of the first device in each group is loaded from scratch,
+ * and the other devices in the group copy it after verifying a sample of the entrypoints, using worker threads for both steps.
+ */
+void volkLoadDeviceTables(struct VolkDeviceTable* tables, const VkDevice* devices, uint32_t count);
+
+struct VolkDeviceTableLoad;
+
+/**
+ * Load function pointers using application-created VkDevice into a table, loading most of them on a background thread.
+ * The commands listed in priorityCommands (e.g. vkCreateSwapchainKHR, vkCreateBuffer) are loaded before this function returns and can be called right away;
+ * other entries must not be used until volkPollDeviceTableLoad returns VK_SUCCESS or volkWaitDeviceTableLoad returns.
+ * The resulting table is identical to the one produced by volkLoadDeviceTable. load must be passed to volkWaitDeviceTableLoad to release it;
+ * it is set to NULL if it can't be allocated, in which case the table is loaded synchronously.
+ */
+void volkLoadDeviceTableAsync(struct VolkDeviceTable* table, VkDevice device, const char* const* priorityCommands, uint32_t priorityCommandCount, struct VolkDeviceTableLoad** load);
+
+/**
+ * Check whether the table load started by volkLoadDeviceTableAsync has finished, without blocking.
+ * Returns VK_NOT_READY while the background thread is loading the table, and VK_SUCCESS afterwards; this can be called from any thread.
+ */
+VkResult volkPollDeviceTableLoad(struct VolkDeviceTableLoad* load);
+
+/**
+ * Wait for the table load started by volkLoadDeviceTableAsync to finish and release load.
+ */
+void volkWaitDeviceTableLoad(struct VolkDeviceTableLoad* load);
+
+/**
+ * Allocate a zero-initialized VolkDeviceTable in its own page-aligned memory, so that it can be made read-only with volkSealDeviceTable after loading.
+ * Returns NULL if the memory can't be allocated; the table must be released with volkFreeSealedDeviceTable.
+ */
+struct VolkDeviceTable* volkAllocateSealedDeviceTable(void);
+
+/**
+ * Make a table allocated with volkAllocateSealedDeviceTable read-only; writes to the table crash instead of silently corrupting it.
+ * Use volkUnsealDeviceTable before loading the table again.
+ */
+VkResult volkSealDeviceTable(struct VolkDeviceTable* table);
+VkResult volkUnsealDeviceTable(struct VolkDeviceTable* table);
+
+void volkFreeSealedDeviceTable(struct VolkDeviceTable* table);
+
+/**
+ * Make the global function pointers read-only; they are placed in their own pages when volk.c is compiled with VOLK_SEAL_GLOBALS defined.
+ * volkInitialize, volkLoadInstance, volkLoadDevice and other functions that load the global function pointers must not be called while they are sealed;
+ * use volkUnsealGlobals first. volkFinalize unseals them automatically.
+ * Returns VK_ERROR_FEATURE_NOT_PRESENT unless VOLK_SEAL_GLOBALS is defined and the compiler and platform support it (GCC with ELF binaries), or if the
+ * system page size is larger than VOLK_SEAL_PAGE_SIZE, which defaults to the largest page size commonly used on the target architecture.
+ */
+VkResult volkSealGlobals(void);
+VkResult volkUnsealGlobals(void);
+
+/**
+ * Load function pointers using application-created VkDevice into a table, skipping the commands that are not provided by the device.
+ * apiVersion should match VkApplicationInfo::apiVersion; enabledExtensionNames should include extensions enabled for both instance and device.
+ * Function pointers for commands from unsupported core versions and extensions are left as NULL.
+ */
+void volkLoadDeviceTableEx(struct VolkDeviceTable* table, VkDevice device, uint32_t apiVersion, const char* const* enabledExtensionNames, uint32_t enabledExtensionCount);
+
+/**
+ * Load function pointers using application-created VkDevice into a table by copying a table previously loaded for another device.
+ * A few entrypoints are looked up to check that both devices use the same driver and layers; if any of them differ, the table is loaded with volkLoadDeviceTable.
+ * The devices should be created with the same API version and extensions.
+ * Returns VK_SUCCESS if the reference table was copied, and VK_INCOMPLETE if the table was loaded from scratch.
+ * With VOLK_INSTRUMENT, the reference is checked using the functions its wrappers forward to, so it should be a table loaded by volk rather than a copy of one.
+ */
+VkResult volkLoadDeviceTableFrom(struct VolkDeviceTable* table, VkDevice device, const struct VolkDeviceTable* reference);
+
+/**
+ * Load function pointers using application-created VkDevice into a custom table that only contains the commands selected when generating volk.
+ * This table is more compact than VolkDeviceTable and only requires looking up the selected commands.
+ */
+void volkLoadCustomDeviceTable(struct VolkCustomDeviceTable* table, VkDevice device);
+
+/**
+ * Load function pointers using application-created VkDevice into a table, using an on-disk cache of entrypoint locations when it is valid.
+ * The cache is keyed by the vendor, device, driverVersion and pipelineCacheUUID of physicalDevice, which are queried with vkGetPhysicalDeviceProperties,
+ * and by the layers and extensions the device was created with; entries read from the cache are checked against the device like volkLoadDeviceTableFrom does.
+ * Returns VK_SUCCESS if the table was filled from the cache; otherwise, loads the table with volkLoadDeviceTable, updates the cache and returns VK_INCOMPLETE.
+ * The cache is only supported on Linux; on other platforms this is equivalent to volkLoadDeviceTable.
+ * The cache stores driver entrypoints, so it can be used with VOLK_INSTRUMENT; the wrappers are installed after the table is read or written.
+ */
+VkResult volkLoadDeviceTableCached(struct VolkDeviceTable* table, VkDevice device, VkPhysicalDevice physicalDevice, const char* cachePath, const char* const* enabledLayerNames, uint32_t enabledLayerCount, const char* const* enabledExtensionNames, uint32_t enabledExtensionCount);
+
+/**
+ * Return a shared copy of a loaded table; tables with the same contents, such as tables loaded for devices that use the same driver and layers, share a single copy.
+ * The copy is reference counted and must be released with volkReleaseDeviceTable. Returns NULL if the copy can't be allocated.
+ */
+const struct VolkDeviceTable* volkInternDeviceTable(const struct VolkDeviceTable* table);
+void volkReleaseDeviceTable(const struct VolkDeviceTable* table);
+
+/**
+ * Compare two tables and call callback (if not NULL) with the command name and both function pointers for every entry that differs.
+ * This can be used to find commands that are intercepted by layers, by comparing tables loaded with and without them.
+ * Returns the number of entries that differ.
+ */
+uint32_t volkDiffDeviceTables(const struct VolkDeviceTable* a, const struct VolkDeviceTable* b, void (*callback)(void* userData, const char* name, PFN_vkVoidFunction functionA, PFN_vkVoidFunction functionB), void* userData);
+
+enum VolkLoadPhase
+{
+	VOLK_LOAD_PHASE_INITIALIZE,     /* volkInitialize, volkInitializeCustom, volkInitializeDirectDriver */
+	VOLK_LOAD_PHASE_INSTANCE,       /* volkLoadInstance, volkLoadInstanceOnly */
+	VOLK_LOAD_PHASE_INSTANCE_TABLE, /* volkLoadInstanceTable */
+	VOLK_LOAD_PHASE_DEVICE,         /* volkLoadDevice */
+	VOLK_LOAD_PHASE_DEVICE_TABLE,   /* volkLoadDeviceTable* */
+	VOLK_LOAD_PHASE_COUNT
+};
+
+#define VOLK_LOAD_STATISTICS_SLOWEST 16
+
+struct VolkLoadPhaseStatistics
+{
+	uint32_t callCount;     /* number of calls to the functions of this phase */
+	uint32_t lookupCount;   /* number of vkGet*ProcAddr calls */
+	uint32_t nullCount;     /* number of vkGet*ProcAddr calls that returned NULL */
+	uint32_t cacheHitCount; /* number of volkLoadDeviceTableCached calls that were served from the cache; these calls are included in callCount */
+	uint64_t time;          /* total wall time spent in this phase, in nanoseconds */
+	uint64_t firstStart;    /* timestamp of the first call, in nanoseconds relative to the first volk call that was measured */
+	uint64_t lastEnd;       /* timestamp of the end of the last call, in nanoseconds relative to the first volk call that was measured */
+};
+
+struct VolkLoadLookupStatistics
+{
+	const char* name;
+	uint32_t phase;
+	uint64_t time; /* in nanoseconds */
+};
+
+struct VolkLoadStatistics
+{
+	struct VolkLoadPhaseStatistics phases[VOLK_LOAD_PHASE_COUNT];
+	struct VolkLoadLookupStatistics slowest[VOLK_LOAD_STATISTICS_SLOWEST]; /* sorted by time, slowest first; unused entries have NULL name */
+};
+
+/**
+ * Get the time and lookup statistics of all loading calls made so far.
+ *
+ * Returns VK_SUCCESS when volk.c is compiled with VOLK_STATISTICS defined, and VK_ERROR_FEATURE_NOT_PRESENT (with zero-filled statistics) otherwise.
+ * Lookups made on first call in VOLK_LAZY mode are not included.
+ */
+VkResult volkGetLoadStatistics(struct VolkLoadStatistics* statistics);
+
+struct VolkCallStats
+{
+	const char* name;
+	uint64_t count;
+	uint64_t time; /* total time spent in the function in nanoseconds; zero unless VOLK_INSTRUMENT_TIMING is defined */
+};
+
+/**
+ * Get the number of calls made through each instance and device function pointer so far, summed over all threads.
+ *
+ * If stats is NULL, statsCount is set to the number of functions that were called; otherwise up to *statsCount entries are written and VK_INCOMPLETE is returned if they don't fit.
+ * Counters are read without locks, so calls made concurrently with the snapshot may or may not be included.
+ * Returns VK_ERROR_FEATURE_NOT_PRESENT unless volk.c is compiled as C++ with VOLK_INSTRUMENT defined.
+ */
+VkResult volkSnapshotCallStats(uint32_t* statsCount, struct VolkCallStats* stats);
+
+/**
+ * Start recording every call made through instance and device function pointers to a file in Chrome trace event format (JSON), which can be opened in Perfetto UI or chrome://tracing.
+ *
+ * Calls are recorded with their begin/end time and thread into per-thread ring buffers, which a background thread writes to the file every few milliseconds; calls that don't fit into a full buffer are dropped.
+ * Returns VK_ERROR_FEATURE_NOT_PRESENT unless volk.c is compiled as C++ with VOLK_INSTRUMENT and VOLK_INSTRUMENT_TRACE defined.
+ */
+VkResult volkStartTrace(const char* path);
+
+/**
+ * Stop recording calls and finish writing the file specified in volkStartTrace.
+ */
+VkResult volkStopTrace(void);
+
+/**
+ * Start recording every call made through instance and device function pointers to a compact binary file.
+ *
+ * Arguments of device commands are serialized after the call using parameter descriptors generated from vk.xml, including the structures, arrays, strings and pNext chains they point to; allocation callbacks and user data pointers are not stored.
+ * Calls whose arguments can't be serialized, such as instance commands, commands without parameter descriptors or commands with extension structures that aren't compiled in, are recorded without arguments; calls that don't fit into a full per-thread buffer are dropped.
+ * Returns VK_ERROR_FEATURE_NOT_PRESENT unless volk.c is compiled as C++ with VOLK_INSTRUMENT and VOLK_INSTRUMENT_CAPTURE defined.
+ */
+VkResult volkStartCapture(const char* path);
+
+/**
+ * Stop recording calls and finish writing the file specified in volkStartCapture.
+ */
+VkResult volkStopCapture(void);
+
+/**
+ * Replay the contents of a capture file through the device table and measure the time spent in each command.
+ *
+ * Handles created by replayed commands are mapped to the handles they had during the capture, and device arguments are replaced with device; commands that use handles which weren't created during replay, commands that failed during the capture and commands recorded without arguments are skipped.
+ * The capture must come from the same build of volk.
+ * Works like volkSnapshotCallStats: if stats is NULL, statsCount is set to the number of replayed commands.
+ * Returns VK_ERROR_FORMAT_NOT_SUPPORTED if the data isn't a valid capture or a record doesn't match the parameters of its command.
+ */
+VkResult volkReplayCapture(const struct VolkDeviceTable* table, VkDevice device, const void* data, size_t size, uint32_t* statsCount, struct VolkCallStats* stats);
+
+/**
+ * Command stream that records vkCmd* commands in memory to be replayed into a command buffer later.
+ *
+ * A stream can be recorded by one thread at a time, so each job thread records into its own stream; streams are replayed into a command buffer on a single thread.
+ * Requires volk.c to be compiled as C++ with VOLK_COMMAND_STREAM defined.
+ */
+struct VolkCommandStream;
+
+/**
+ * Create an empty command stream.
+ * Returns VK_ERROR_FEATURE_NOT_PRESENT unless volk.c is compiled as C++ with VOLK_COMMAND_STREAM defined.
+ */
+VkResult volkCreateCommandStream(struct VolkCommandStream** stream);
+
+/**
+ * Destroy the command stream and free its memory.
+ */
+void volkDestroyCommandStream(struct VolkCommandStream* stream);
+
+/**
+ * Remove all recorded commands and data from the stream; the memory is kept for recording the stream again.
+ */
+void volkResetCommandStream(struct VolkCommandStream* stream);
+
+/**
+ * Return the handle to pass as the command buffer to functions from a table loaded with volkLoadCommandStreamTable.
+ */
+VkCommandBuffer volkGetCommandStreamHandle(struct VolkCommandStream* stream);
+
+/**
+ * Allocate memory that stays valid until the stream is reset or destroyed, aligned to 8 bytes.
+ */
+void* volkAllocateCommandStreamData(struct VolkCommandStream* stream, size_t size);
+
+/**
+ * Load a device table with functions that record vkCmd* commands into the stream passed as the command buffer; other functions are NULL.
+ *
+ * Arrays, strings and structures that arguments point to, including pNext chains, are copied into the stream when the command is recorded, so they don't need to stay valid until the stream is replayed.
+ */
+void volkLoadCommandStreamTable(struct VolkDeviceTable* table);
+
+/**
+ * Replay all commands recorded in the stream into the command buffer using functions from the device table; commands that are NULL in the table are skipped.
+ *
+ * Returns VK_ERROR_OUT_OF_HOST_MEMORY without replaying any commands if the stream ran out of memory while recording,
+ * or VK_ERROR_FEATURE_NOT_PRESENT if a recorded command took pointers to data that vk.xml doesn't describe, such as a pNext structure this build doesn't know about.
+ * Pointers are copied using the parameter descriptors that generate.py emits into volk.c; if volk.c was generated without them, any command that takes a pointer makes the replay fail.
+ */
+VkResult volkReplayCommandStream(const struct VolkDeviceTable* table, VkCommandBuffer commandBuffer, const struct VolkCommandStream* stream);
+
+/**
+ * Register the table for the device, so that it can be found from the device and its queues and command buffers with volkGetDeviceTable.
+ *
+ * The table is not copied and must stay valid until the device is unregistered; registering a device again replaces its table.
+ * Lookups don't take locks; up to 64 devices can be registered at the same time, and VK_ERROR_OUT_OF_HOST_MEMORY is returned when the registry is full.
+ * Devices can be registered and unregistered from any thread, but a device must not be used while it is being unregistered.
+ * Returns VK_ERROR_FEATURE_NOT_PRESENT after volkInitializeDirectDriver, since the handles of a driver loaded without the loader can't be told apart.
+ */
+VkResult volkRegisterDevice(const struct VolkDeviceTable* table, VkDevice device);
+
+/**
+ * Remove the table registered for the device; must be called before the device is destroyed. Its entry is reused by later registrations.
+ */
+void volkUnregisterDevice(VkDevice device);
+
+/**
+ * Return the table registered for the device that owns the dispatchable handle (VkDevice, VkQueue or VkCommandBuffer), or NULL.
+ */
+const struct VolkDeviceTable* volkGetDeviceTable(const void* handle);
+
+/**
+ * Write the number of calls made through each instance and device function pointer to a file, one "name count" line per called function.
+ *
+ * The file can be passed to generate.py --profile to place the most frequently called functions at the start of VolkInstanceTable and VolkDeviceTable.
+ * Returns VK_ERROR_FEATURE_NOT_PRESENT unless volk.c is compiled as C++ with VOLK_INSTRUMENT defined.
+ */
+VkResult volkWriteProfile(const char* path);
+
 #ifdef __cplusplus
 } // extern "C" / namespace volk
 #endif
@@ -2080,6 +2406,40 @@ struct VolkDeviceTable
 	/* VOLK_GENERATE_DEVICE_TABLE */
 };
 
+/**
+ * Device function pointer table for a subset of device commands, selected when generating volk (see generate.py --custom-device-table)
+ */
+struct VolkCustomDeviceTable
+{
+	/* VOLK_GENERATE_CUSTOM_DEVICE_TABLE */
+#if defined(VK_VERSION_1_0)
+	PFN_vkCmdBindDescriptorSets vkCmdBindDescriptorSets;
+	PFN_vkCmdBindIndexBuffer vkCmdBindIndexBuffer;
+	PFN_vkCmdBindPipeline vkCmdBindPipeline;
+	PFN_vkCmdBindVertexBuffers vkCmdBindVertexBuffers;
+	PFN_vkCmdCopyBuffer vkCmdCopyBuffer;
+	PFN_vkCmdDispatch vkCmdDispatch;
+	PFN_vkCmdDraw vkCmdDraw;
+	PFN_vkCmdDrawIndexed vkCmdDrawIndexed;
+	PFN_vkCmdDrawIndexedIndirect vkCmdDrawIndexedIndirect;
+	PFN_vkCmdDrawIndirect vkCmdDrawIndirect;
+	PFN_vkCmdPipelineBarrier vkCmdPipelineBarrier;
+	PFN_vkCmdPushConstants vkCmdPushConstants;
+	PFN_vkCmdSetScissor vkCmdSetScissor;
+	PFN_vkCmdSetViewport vkCmdSetViewport;
+#else
+	PFN_vkVoidFunction padding_828bba45[14];
+#endif /* defined(VK_VERSION_1_0) */
+#if defined(VK_VERSION_1_3)
+	PFN_vkCmdBeginRendering vkCmdBeginRendering;
+	PFN_vkCmdEndRendering vkCmdEndRendering;
+	PFN_vkCmdPipelineBarrier2 vkCmdPipelineBarrier2;
+#else
+	PFN_vkVoidFunction padding_dc72f8e7[3];
+#endif /* defined(VK_VERSION_1_3) */
+	/* VOLK_GENERATE_CUSTOM_DEVICE_TABLE */
+};
+
 /* VOLK_GENERATE_PROTOTYPES_H */
 #if defined(VK_VERSION_1_0)
 extern PFN_vkCreateDevice vkCreateDevice;
@@ -3424,6 +3784,19 @@ extern PFN_vkAcquireNextImage2KHR vkAcquireNextImage2KHR;
 /* VOLK_GENERATE_PROTOTYPES_H_DEVICE */
 #endif
 
+#ifdef VOLK_DEVICE_REGISTRY
+/**
+ * Functions named after device-level commands with a volk prefix (volkCmdDraw for vkCmdDraw) that call the table registered with volkRegisterDevice
+ * for the dispatchable handle passed as the first argument. This allows calling Vulkan functions directly with multiple devices at the cost of a registry lookup per call.
+ *
+ * Calls through handles of devices that aren't registered, or to functions that aren't loaded in the registered table, return VK_ERROR_INITIALIZATION_FAILED or 0.
+ * Requires volk.c and the code that includes volk.h to be compiled with VOLK_DEVICE_REGISTRY defined.
+ * The functions are generated from vk.xml by generate.py, which also defines VOLK_REGISTRY_FUNCTIONS; until then, only volkRegisterDevice and volkGetDeviceTable are available.
+ */
+/* VOLK_GENERATE_REGISTRY_PROTOTYPES_H */
+/* VOLK_GENERATE_REGISTRY_PROTOTYPES_H */
+#endif
+
 #ifdef __cplusplus
 } // extern "C" / namespace volk
 #endif
@@ -3432,6 +3805,60 @@ extern PFN_vkAcquireNextImage2KHR vkAcquireNextImage2KHR;
 using namespace volk;
 #endif
 
+#if defined(VOLK_DEVICE_DISPATCH) && defined(__cplusplus) && (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#if defined(_MSC_VER)
+#	define VOLK_FORCEINLINE __forceinline
+#elif defined(__GNUC__)
+#	define VOLK_FORCEINLINE inline __attribute__((always_inline))
+#else
+#	define VOLK_FORCEINLINE inline
+#endif
+
+/* With VOLK_DISPATCH_NULL_CHECK defined, calling a function that wasn't loaded does nothing and returns a value-initialized result;
+ * the check is marked as likely to pass, so it costs a predicted branch. Otherwise the call is a single indirect call. */
+#if defined(VOLK_DISPATCH_NULL_CHECK) && defined(__GNUC__)
+#	define VOLK_DISPATCH_CALL(name, args) return __builtin_expect(table.name != nullptr, 1) ? table.name args : decltype(table.name args)()
+#elif defined(VOLK_DISPATCH_NULL_CHECK)
+#	define VOLK_DISPATCH_CALL(name, args) return table.name != nullptr ? table.name args : decltype(table.name args)()
+#else
+#	define VOLK_DISPATCH_CALL(name, args) return table.name args
+#endif
+
+namespace volk {
+
+/**
+ * Device function table with a member function for every command, called with the exact parameter types of the command, e.g. dispatch.vkCmdDraw(commandBuffer, 3, 1, 0, 0).
+ * Wraps a VolkDeviceTable, so it has the same layout; whether a function was loaded can be checked with dispatch.table.vkCmdDraw != NULL.
+ * Only available when VOLK_DEVICE_DISPATCH is defined before including volk.h.
+ */
+class DeviceDispatch
+{
+public:
+	VolkDeviceTable table;
+
+	DeviceDispatch() noexcept : table()
+	{
+	}
+
+	explicit DeviceDispatch(const VolkDeviceTable& table) noexcept : table(table)
+	{
+	}
+
+	explicit DeviceDispatch(VkDevice device) noexcept : table()
+	{
+		volkLoadDeviceTable(&this->table, device);
+	}
+
+	/* member functions are generated from vk.xml by generate.py, which also defines VOLK_DISPATCH_FUNCTIONS; they are noexcept because the commands are C functions */
+	/* VOLK_GENERATE_DEVICE_DISPATCH */
+	/* VOLK_GENERATE_DEVICE_DISPATCH */
+};
+
+static_assert(sizeof(DeviceDispatch) == sizeof(VolkDeviceTable), "DeviceDispatch must have the same layout as VolkDeviceTable");
+
+} // namespace volk
+#endif
+
 #endif // VOLK_H
 
 #ifdef VOLK_IMPLEMENTATION